@@ -2,7 +2,9 @@
 #include <QTextStream>
 #include <QDir>
 
-ProjectMgr::ProjectMgr() : isModified(false) {}
+ProjectMgr::ProjectMgr()
+    : isModified(false), historyLimit(64 * 1024 * 1024), historyUsage(0),
+      currentVersion(0), savedVersion(0), versionCounter(0) {}
 
 ProjectMgr::~ProjectMgr() {}
 
@@ -26,6 +28,7 @@ bool ProjectMgr::loadProject(const QString& filePath) {
 
     // Clear existing data
     swathGroups.clear();
+    clearHistory();
 
     // Parse the document
     const QDomElement root = doc.documentElement();
@@ -41,6 +44,8 @@ bool ProjectMgr::loadProject(const QString& filePath) {
 
     currentFilePath = filePath;
     isModified = false;
+    currentVersion = ++versionCounter;
+    savedVersion = currentVersion;
     return true;
 }
 
@@ -71,6 +76,7 @@ bool ProjectMgr::saveProject(const QString& filePath) {
     
     currentFilePath = filePath;
     isModified = false;
+    savedVersion = currentVersion;
     return true;
 }
 
@@ -97,6 +103,7 @@ bool ProjectMgr::addSwathGroup(const SwathGroup& group) {
     if (findSwathGroup(group.name)) {
         return false; // Group with this name already exists
     }
+    recordHistory(nullptr, &group);
     swathGroups.append(group);
     isModified = true;
     return true;
@@ -104,7 +111,8 @@ bool ProjectMgr::addSwathGroup(const SwathGroup& group) {
 
 bool ProjectMgr::removeSwathGroup(const QString& name) {
     for (int i = 0; i < swathGroups.size(); ++i) {
-        if (swathGroups[i].name == name) {
+        if (swathGroups.at(i).name == name) {
+            recordHistory(&swathGroups.at(i), nullptr);
             swathGroups.removeAt(i);
             isModified = true;
             return true;
@@ -115,7 +123,14 @@ bool ProjectMgr::removeSwathGroup(const QString& name) {
 
 bool ProjectMgr::updateSwathGroup(const QString& name, const SwathGroup& newGroup) {
     for (int i = 0; i < swathGroups.size(); ++i) {
-        if (swathGroups[i].name == name) {
+        if (swathGroups.at(i).name == name) {
+            if (&newGroup == &swathGroups.at(i)) {
+                // Already edited in place, so there is no old version to keep
+                currentVersion = ++versionCounter;
+                isModified = true;
+                return true;
+            }
+            recordHistory(&swathGroups.at(i), &newGroup);
             swathGroups[i] = newGroup;
             isModified = true;
             return true;
@@ -137,6 +152,173 @@ QVector<SwathGroup> ProjectMgr::getAllSwathGroups() const {
     return swathGroups;
 }
 
+bool ProjectMgr::canUndo() const {
+    return !undoStack.isEmpty();
+}
+
+bool ProjectMgr::canRedo() const {
+    return !redoStack.isEmpty();
+}
+
+bool ProjectMgr::undo() {
+    if (undoStack.isEmpty()) {
+        return false;
+    }
+    // The current version moves to the redo stack, where it is charged the
+    // bytes it does not share with the version being restored
+    HistoryEntry entry = undoStack.takeLast();
+    historyUsage += entry.redoCost - entry.undoCost;
+    redoStack.append({swathGroups, entry.undoCost, entry.redoCost, currentVersion});
+    swathGroups = entry.swathGroups;
+    currentVersion = entry.version;
+    isModified = currentVersion != savedVersion;
+    trimHistory();
+    return true;
+}
+
+bool ProjectMgr::redo() {
+    if (redoStack.isEmpty()) {
+        return false;
+    }
+    HistoryEntry entry = redoStack.takeLast();
+    historyUsage += entry.undoCost - entry.redoCost;
+    undoStack.append({swathGroups, entry.undoCost, entry.redoCost, currentVersion});
+    swathGroups = entry.swathGroups;
+    currentVersion = entry.version;
+    isModified = currentVersion != savedVersion;
+    trimHistory();
+    return true;
+}
+
+void ProjectMgr::clearHistory() {
+    undoStack.clear();
+    redoStack.clear();
+    historyUsage = 0;
+}
+
+void ProjectMgr::setHistoryMemoryLimit(qint64 bytes) {
+    historyLimit = qMax<qint64>(0, bytes);
+    trimHistory();
+}
+
+qint64 ProjectMgr::historyMemoryLimit() const {
+    return historyLimit;
+}
+
+qint64 ProjectMgr::historyMemoryUsage() const {
+    return historyUsage;
+}
+
+void ProjectMgr::recordHistory(const SwathGroup* oldGroup, const SwathGroup* newGroup) {
+    // The snapshot gets its own top-level array so that swathGroups keeps
+    // its buffer and findSwathGroup() pointers stay valid; the groups inside
+    // stay shared. Only the top-level array and the parts of the changed
+    // group that differ are charged.
+    const SwathGroup empty{};
+    const qsizetype newCount = swathGroups.size() + (newGroup ? 1 : 0) - (oldGroup ? 1 : 0);
+    qint64 undoCost = swathGroups.size() * static_cast<qint64>(sizeof(SwathGroup));
+    qint64 redoCost = newCount * static_cast<qint64>(sizeof(SwathGroup));
+    if (oldGroup) {
+        undoCost += uniqueSize(*oldGroup, newGroup ? *newGroup : empty);
+    }
+    if (newGroup) {
+        redoCost += uniqueSize(*newGroup, oldGroup ? *oldGroup : empty);
+    }
+
+    for (const HistoryEntry& entry : redoStack) {
+        historyUsage -= entry.redoCost;
+    }
+    redoStack.clear();
+    QVector<SwathGroup> snapshot = swathGroups;
+    snapshot.detach();
+    undoStack.append({snapshot, undoCost, redoCost, currentVersion});
+    historyUsage += undoCost;
+    currentVersion = ++versionCounter;
+    trimHistory();
+}
+
+void ProjectMgr::trimHistory() {
+    if (historyLimit == 0) {
+        return;
+    }
+    // Drop the oldest undo steps first, then the furthest redo steps
+    while (historyUsage > historyLimit && !undoStack.isEmpty()) {
+        historyUsage -= undoStack.first().undoCost;
+        undoStack.removeFirst();
+    }
+    while (historyUsage > historyLimit && !redoStack.isEmpty()) {
+        historyUsage -= redoStack.first().redoCost;
+        redoStack.removeFirst();
+    }
+}
+
+qint64 ProjectMgr::uniqueSize(const QString& str, const QString& base) {
+    if (str.constData() == base.constData()) {
+        return 0;
+    }
+    return str.size() * static_cast<qint64>(sizeof(QChar));
+}
+
+qint64 ProjectMgr::uniqueSize(const QMap<QString, QString>& filterItem,
+                              const QMap<QString, QString>& base) {
+    if (filterItem.isSharedWith(base)) {
+        return 0;
+    }
+    qint64 size = 0;
+    for (auto it = filterItem.begin(); it != filterItem.end(); ++it) {
+        auto baseIt = base.constFind(it.key());
+        if (baseIt == base.constEnd()) {
+            size += uniqueSize(it.key(), QString()) + uniqueSize(it.value(), QString());
+        } else {
+            size += uniqueSize(it.value(), baseIt.value());
+        }
+    }
+    return size;
+}
+
+qint64 ProjectMgr::uniqueSize(const DataProcessingParameters& params,
+                              const DataProcessingParameters& base) {
+    qint64 size = uniqueSize(params.cutType, base.cutType) + uniqueSize(params.name, base.name);
+    if (params.filterItems.constData() == base.filterItems.constData()) {
+        return size;
+    }
+    const QMap<QString, QString> empty;
+    size += params.filterItems.size() * static_cast<qint64>(sizeof(QMap<QString, QString>));
+    for (int i = 0; i < params.filterItems.size(); ++i) {
+        size += uniqueSize(params.filterItems.at(i),
+                           i < base.filterItems.size() ? base.filterItems.at(i) : empty);
+    }
+    return size;
+}
+
+qint64 ProjectMgr::uniqueSize(const Array& array, const Array& base) {
+    qint64 size = uniqueSize(array.antennaName, base.antennaName);
+    if (array.processingParams.constData() == base.processingParams.constData()) {
+        return size;
+    }
+    const DataProcessingParameters empty{};
+    size += array.processingParams.size() * static_cast<qint64>(sizeof(DataProcessingParameters));
+    for (int i = 0; i < array.processingParams.size(); ++i) {
+        size += uniqueSize(array.processingParams.at(i),
+                           i < base.processingParams.size() ? base.processingParams.at(i) : empty);
+    }
+    return size;
+}
+
+qint64 ProjectMgr::uniqueSize(const SwathGroup& group, const SwathGroup& base) {
+    qint64 size = uniqueSize(group.name, base.name) + uniqueSize(group.folder, base.folder);
+    if (group.arrays.constData() == base.arrays.constData()) {
+        return size;
+    }
+    const Array empty{};
+    size += group.arrays.size() * static_cast<qint64>(sizeof(Array));
+    for (int i = 0; i < group.arrays.size(); ++i) {
+        size += uniqueSize(group.arrays.at(i),
+                           i < base.arrays.size() ? base.arrays.at(i) : empty);
+    }
+    return size;
+}
+
 SwathGroup ProjectMgr::parseSwathGroup(const QDomElement& element) {
     SwathGroup group;
     group.name = element.attribute("name");
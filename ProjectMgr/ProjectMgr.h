@@ -48,11 +48,53 @@ public:
   SwathGroup *findSwathGroup(const QString &name);
   QVector<SwathGroup> getAllSwathGroups() const;
 
+  // Undo/redo operations
+  // Snapshots rely on Qt implicit sharing: unchanged groups, arrays and
+  // parameters are shared between versions, so undo()/redo() are O(1).
+  // Edits made directly through findSwathGroup() are not recorded, and
+  // passing such an edited group back to updateSwathGroup() records no
+  // step either. undo()/redo() invalidate pointers from findSwathGroup().
+  bool canUndo() const;
+  bool canRedo() const;
+  bool undo();
+  bool redo();
+  void clearHistory();
+  void setHistoryMemoryLimit(qint64 bytes);  // 0 means unlimited
+  qint64 historyMemoryLimit() const;
+  qint64 historyMemoryUsage() const;  // Estimated bytes held by history
+
 private:
+  // Costs are the estimated bytes this version does not share with the
+  // neighbouring one, depending on which stack the entry is on
+  struct HistoryEntry {
+    QVector<SwathGroup> swathGroups;
+    qint64 undoCost;
+    qint64 redoCost;
+    quint64 version;
+  };
+
   QVector<SwathGroup> swathGroups;
   QDomDocument doc;
   QString currentFilePath;  // Track current file path
   bool isModified;  // Track if there are unsaved changes
+  QVector<HistoryEntry> undoStack;
+  QVector<HistoryEntry> redoStack;
+  qint64 historyLimit;  // Memory cap for undo/redo history in bytes
+  qint64 historyUsage;
+  quint64 currentVersion;  // Identifies the current swathGroups version
+  quint64 savedVersion;  // Version last loaded from or saved to file
+  quint64 versionCounter;
+
+  // History helpers
+  void recordHistory(const SwathGroup *oldGroup, const SwathGroup *newGroup);
+  void trimHistory();
+  static qint64 uniqueSize(const QString &str, const QString &base);
+  static qint64 uniqueSize(const QMap<QString, QString> &filterItem,
+                           const QMap<QString, QString> &base);
+  static qint64 uniqueSize(const DataProcessingParameters &params,
+                           const DataProcessingParameters &base);
+  static qint64 uniqueSize(const Array &array, const Array &base);
+  static qint64 uniqueSize(const SwathGroup &group, const SwathGroup &base);
 
   // Helper methods
   SwathGroup parseSwathGroup(const QDomElement &element);
@@ -232,6 +232,167 @@ int main(int argc, char *argv[])
         qDebug() << "另存为失败";
     }
     
+    // 测试撤销/重做功能
+    qDebug() << "\n测试撤销/重做功能...";
+    int failures = 0;
+    auto check = [&failures](bool ok, const QString& label) {
+        qDebug() << label << (ok ? "通过" : "失败");
+        if (!ok) {
+            ++failures;
+        }
+    };
+
+    projectMgr.setHistoryMemoryLimit(16 * 1024 * 1024);
+    const int groupCountBefore = projectMgr.getAllSwathGroups().size();
+    SwathGroup undoGroup = newGroup;
+    undoGroup.name = "Survey_Undo_Test";
+    projectMgr.addSwathGroup(undoGroup);
+    check(projectMgr.getAllSwathGroups().size() == groupCountBefore + 1, "添加后SwathGroup数量");
+    qDebug() << "历史记录占用内存(字节):" << projectMgr.historyMemoryUsage();
+
+    check(projectMgr.undo() && projectMgr.getAllSwathGroups().size() == groupCountBefore,
+          "撤销添加后SwathGroup数量");
+    check(projectMgr.redo() && projectMgr.getAllSwathGroups().size() == groupCountBefore + 1,
+          "重做添加后SwathGroup数量");
+
+    // 撤销修改应恢复原有内容
+    const SwathGroup originalGroup = *projectMgr.findSwathGroup("Survey_Undo_Test");
+    SwathGroup editedGroup = originalGroup;
+    editedGroup.propagationVelocity = 1234.0;
+    editedGroup.arrays[0].processingParams[0].name = "UndoParams";
+    projectMgr.updateSwathGroup("Survey_Undo_Test", editedGroup);
+    const SwathGroup* undoFound = projectMgr.findSwathGroup("Survey_Undo_Test");
+    check(undoFound->propagationVelocity == 1234.0
+              && undoFound->arrays[0].processingParams[0].name == "UndoParams",
+          "修改后内容");
+    check(projectMgr.undo(), "撤销修改");
+    undoFound = projectMgr.findSwathGroup("Survey_Undo_Test");
+    check(undoFound->propagationVelocity == originalGroup.propagationVelocity
+              && undoFound->arrays[0].processingParams[0].name
+                     == originalGroup.arrays[0].processingParams[0].name,
+          "撤销修改后恢复原有内容");
+
+    // 新的编辑应清空重做栈
+    check(projectMgr.canRedo(), "撤销后可以重做");
+    projectMgr.updateSwathGroup("Survey_Undo_Test", editedGroup);
+    check(!projectMgr.canRedo(), "新的编辑后不能重做");
+
+    // 撤销回已保存版本后应没有未保存的更改
+    projectMgr.save();
+    editedGroup.propagationVelocity = 1500.0;
+    projectMgr.updateSwathGroup("Survey_Undo_Test", editedGroup);
+    check(projectMgr.hasUnsavedChanges(), "修改后有未保存的更改");
+    check(projectMgr.undo(), "撤销到已保存版本");
+    check(!projectMgr.hasUnsavedChanges(), "撤销到已保存版本后没有未保存的更改");
+    check(projectMgr.redo(), "重做到修改后版本");
+    check(projectMgr.hasUnsavedChanges(), "重做后有未保存的更改");
+
+    // 内存上限应丢弃最早的历史记录
+    editedGroup.propagationVelocity = 0.0;
+    projectMgr.updateSwathGroup("Survey_Undo_Test", editedGroup);
+    projectMgr.clearHistory();
+    check(projectMgr.historyMemoryUsage() == 0, "清空历史记录后占用内存为0");
+    for (int step = 1; step <= 10; ++step) {
+        editedGroup.propagationVelocity = step;
+        editedGroup.arrays[0].processingParams[0].name = QString("Step%1").arg(step);
+        projectMgr.updateSwathGroup("Survey_Undo_Test", editedGroup);
+    }
+    const qint64 usageBeforeLimit = projectMgr.historyMemoryUsage();
+    qDebug() << "10次修改后历史记录占用内存(字节):" << usageBeforeLimit;
+    check(usageBeforeLimit > 0, "历史记录占用内存大于0");
+    projectMgr.setHistoryMemoryLimit(usageBeforeLimit / 2);
+    qDebug() << "设置上限后历史记录占用内存(字节):" << projectMgr.historyMemoryUsage();
+    check(projectMgr.historyMemoryUsage() <= projectMgr.historyMemoryLimit()
+              && projectMgr.historyMemoryUsage() < usageBeforeLimit,
+          "设置上限后占用内存降低");
+    int undoSteps = 0;
+    while (projectMgr.undo()) {
+        ++undoSteps;
+    }
+    check(projectMgr.historyMemoryUsage() <= projectMgr.historyMemoryLimit(),
+          "撤销后占用内存不超过上限");
+    undoFound = projectMgr.findSwathGroup("Survey_Undo_Test");
+    qDebug() << "可撤销步数:" << undoSteps << "最早可恢复的传播速度:" << undoFound->propagationVelocity;
+    check(undoSteps > 0 && undoSteps < 10, "可撤销步数少于修改次数");
+    check(undoFound->propagationVelocity == 10 - undoSteps, "最早的历史记录已被丢弃");
+    while (projectMgr.redo()) {
+    }
+    check(projectMgr.findSwathGroup("Survey_Undo_Test")->propagationVelocity == 10.0,
+          "重做全部后恢复最新版本");
+
+    // 修改单个参数名称只应计入变化的路径
+    projectMgr.clearHistory();
+    projectMgr.setHistoryMemoryLimit(0);
+    SwathGroup memoryGroup;
+    memoryGroup.name = "Survey_Memory_Test";
+    memoryGroup.visible = true;
+    memoryGroup.folder = "Survey_Memory_Test";
+    memoryGroup.propagationVelocity = 1500.0;
+    for (int arrayIndex = 0; arrayIndex < 20; ++arrayIndex) {
+        Array memoryArray;
+        memoryArray.antennaName = QString("MemoryAntenna%1").arg(arrayIndex);
+        memoryArray.id = arrayIndex;
+        for (int paramIndex = 0; paramIndex < 5; ++paramIndex) {
+            DataProcessingParameters memoryParams = processingParams;
+            memoryParams.name = QString("MemoryParams%1_%2").arg(arrayIndex).arg(paramIndex);
+            memoryParams.filterItems.append(filter);
+            memoryArray.processingParams.append(memoryParams);
+        }
+        memoryGroup.arrays.append(memoryArray);
+    }
+    qint64 memoryGroupSize = sizeof(SwathGroup);
+    for (const Array& memoryArray : memoryGroup.arrays) {
+        memoryGroupSize += sizeof(Array) + memoryArray.antennaName.size() * sizeof(QChar);
+        for (const DataProcessingParameters& memoryParams : memoryArray.processingParams) {
+            memoryGroupSize += sizeof(DataProcessingParameters)
+                               + (memoryParams.cutType.size() + memoryParams.name.size()) * sizeof(QChar);
+            for (const QMap<QString, QString>& memoryFilter : memoryParams.filterItems) {
+                for (auto it = memoryFilter.begin(); it != memoryFilter.end(); ++it) {
+                    memoryGroupSize += (it.key().size() + it.value().size()) * sizeof(QChar);
+                }
+            }
+        }
+    }
+    check(projectMgr.addSwathGroup(memoryGroup), "添加内存测试SwathGroup");
+
+    auto renameCost = [&projectMgr](const QString& paramsName) {
+        const qint64 usageBefore = projectMgr.historyMemoryUsage();
+        SwathGroup renamedGroup = *projectMgr.findSwathGroup("Survey_Memory_Test");
+        renamedGroup.arrays[0].processingParams[0].name = paramsName;
+        projectMgr.updateSwathGroup("Survey_Memory_Test", renamedGroup);
+        return projectMgr.historyMemoryUsage() - usageBefore;
+    };
+    // 先改成同样长度的名称, 让两次测量中被替换的旧字符串大小相同
+    renameCost("RenameA");
+    const qint64 topLevelCost = projectMgr.getAllSwathGroups().size() * static_cast<qint64>(sizeof(SwathGroup));
+    const qint64 firstRenameCost = renameCost("RenameB");
+    qDebug() << "修改参数名称的历史记录开销(字节):" << firstRenameCost
+             << "完整复制开销:" << topLevelCost + memoryGroupSize;
+    check(firstRenameCost > topLevelCost && firstRenameCost < topLevelCost + memoryGroupSize
+              && (firstRenameCost - topLevelCost) * 4 < memoryGroupSize,
+          "修改参数名称只计入变化的路径");
+
+    const int extraGroupCount = 5;
+    for (int extraIndex = 0; extraIndex < extraGroupCount; ++extraIndex) {
+        SwathGroup extraGroup = memoryGroup;
+        extraGroup.name = QString("Survey_Memory_Extra_%1").arg(extraIndex);
+        check(projectMgr.addSwathGroup(extraGroup), "添加额外SwathGroup");
+    }
+    const qint64 secondRenameCost = renameCost("RenameA");
+    qDebug() << "增加SwathGroup后修改参数名称的开销(字节):" << secondRenameCost;
+    check(secondRenameCost - firstRenameCost == extraGroupCount * static_cast<qint64>(sizeof(SwathGroup)),
+          "修改开销与其他SwathGroup的内容无关");
+
+    // 撤销添加会把整个SwathGroup计入重做栈, 占用内存仍不应超过上限
+    for (int step = 0; step < extraGroupCount + 3; ++step) {
+        check(projectMgr.undo(), "撤销内存测试中的修改");
+    }
+    projectMgr.setHistoryMemoryLimit(projectMgr.historyMemoryUsage() + 1024);
+    check(projectMgr.undo() && !projectMgr.findSwathGroup("Survey_Memory_Test"), "撤销添加内存测试SwathGroup");
+    check(projectMgr.historyMemoryUsage() <= projectMgr.historyMemoryLimit(),
+          "撤销添加后占用内存不超过上限");
+    projectMgr.setHistoryMemoryLimit(16 * 1024 * 1024);
+
     // 显示修改后的所有SwathGroup
     qDebug() << "\n显示修改后的所有SwathGroup:";
     groups = projectMgr.getAllSwathGroups();
@@ -267,8 +428,8 @@ int main(int argc, char *argv[])
         }
     }
     
-    qDebug() << "\n测试完成";
-    return 0;
+    qDebug() << "\n测试完成, 失败数量:" << failures;
+    return failures > 0 ? 1 : 0;
 }
 
 